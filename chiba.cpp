@@ -1,11 +1,15 @@
 #include "graph.h"
+#include "subgraph.h"
+#include "stats.h"
 #include <algorithm>
 #include <chrono>
 
 class ChibaSimple {
 private:
     const Graph& graph;
-    std::vector<std::vector<int>> cliques;
+    const GraphArtifacts& artifacts;
+    CliqueStats& sink;
+    LocalSubgraph local; // the current seed's neighborhood; the search runs on its local ids
 
     int getTotalVertices() {
         int total = graph.size();
@@ -32,22 +36,6 @@ private:
         return flags;
     }
 
-    int countEdges(int vertex) {
-        int edges = graph[vertex].size();
-        return edges;
-    }
-
-    int hasValue(int number, std::vector<int> list) {
-        int index = 0;
-        while (index < list.size()) {
-            if (list[index] == number) {
-                return 1;
-            }
-            index = index + 1;
-        }
-        return 0;
-    }
-
     int choosePivotVertex(std::vector<int> candidates) {
         int pivot = -1;
         int maxEdges = -1;
@@ -58,7 +46,7 @@ private:
             int inner = 0;
             while (inner < candidates.size()) {
                 int other = candidates[inner];
-                int found = hasValue(other, graph[vertex]);
+                int found = local.connected(vertex, other);
                 if (found) {
                     edgeCount = edgeCount + 1;
                 }
@@ -112,12 +100,22 @@ private:
         return empty;
     }
 
+    std::vector<int> mapToLocal(std::vector<int> globalList) {
+        std::vector<int> localList;
+        int position = 0;
+        while (position < globalList.size()) {
+            addToList(localList, local.toLocal(globalList[position]));
+            position = position + 1;
+        }
+        return localList;
+    }
+
     void exploreCliques(std::vector<int>& current, std::vector<int>& excluded, std::vector<int>& candidates) {
         int candEmpty = isListEmpty(candidates);
         int exclEmpty = isListEmpty(excluded);
         int bothEmpty = candEmpty && exclEmpty;
         if (bothEmpty) {
-            cliques.push_back(current);
+            sink.record(current, local.globalLabels());
             return;
         }
 
@@ -127,7 +125,7 @@ private:
         int index = 0;
         while (index < candCopy.size()) {
             int vertex = candCopy[index];
-            int connected = hasValue(vertex, graph[pivot]);
+            int connected = local.connected(pivot, vertex);
             if (connected) {
                 index = index + 1;
                 continue;
@@ -139,7 +137,7 @@ private:
             int candIndex = 0;
             while (candIndex < candidates.size()) {
                 int candVertex = candidates[candIndex];
-                int linked = hasValue(candVertex, graph[vertex]);
+                int linked = local.connected(vertex, candVertex);
                 if (linked) {
                     addToList(newCandidates, candVertex);
                 }
@@ -150,7 +148,7 @@ private:
             int exclIndex = 0;
             while (exclIndex < excluded.size()) {
                 int exclVertex = excluded[exclIndex];
-                int linked = hasValue(exclVertex, graph[vertex]);
+                int linked = local.connected(vertex, exclVertex);
                 if (linked) {
                     addToList(newExcluded, exclVertex);
                 }
@@ -166,36 +164,16 @@ private:
         }
     }
 
-    std::vector<std::pair<int, int>> listVertexDegrees() {
-        std::vector<std::pair<int, int>> degrees;
-        int vertex = 0;
-        while (vertex < graph.size()) {
-            int edgeCount = countEdges(vertex);
-            int hasEdges = edgeCount > 0;
-            if (hasEdges) {
-                std::pair<int, int> degreePair = std::make_pair(edgeCount, vertex);
-                degrees.push_back(degreePair);
-            }
-            vertex = vertex + 1;
-        }
-        return degrees;
-    }
-
-    void sortDegrees(std::vector<std::pair<int, int>>& degrees) {
-        std::sort(degrees.begin(), degrees.end());
-    }
-
 public:
-    ChibaSimple(const Graph& inputGraph) : graph(inputGraph) {}
+    ChibaSimple(const Graph& inputGraph, const GraphArtifacts& inputArtifacts, CliqueStats& output)
+        : graph(inputGraph), artifacts(inputArtifacts), sink(output), local(inputGraph) {}
 
-    std::vector<std::vector<int>> findAllCliques() {
-        cliques.clear();
-        std::vector<std::pair<int, int>> vertexDegrees = listVertexDegrees();
-        sortDegrees(vertexDegrees);
+    void findAllCliques() {
+        const std::vector<int>& vertexOrder = artifacts.degreeOrder;
 
-        int pairIndex = 0;
-        while (pairIndex < vertexDegrees.size()) {
-            int vertex = vertexDegrees[pairIndex].second;
+        int orderIndex = 0;
+        while (orderIndex < vertexOrder.size()) {
+            int vertex = vertexOrder[orderIndex];
             std::vector<int> current;
             addToList(current, vertex);
             std::vector<int> candidates;
@@ -204,16 +182,11 @@ public:
             int neighborIndex = 0;
             while (neighborIndex < graph[vertex].size()) {
                 int neighbor = graph[vertex][neighborIndex];
-                int neighborEdges = countEdges(neighbor);
-                int vertexEdges = countEdges(vertex);
-                int moreEdges = neighborEdges > vertexEdges;
-                int sameEdges = neighborEdges == vertexEdges;
-                int higherVertex = neighbor > vertex;
-                int lessEdges = neighborEdges < vertexEdges;
-                int lowerVertex = neighbor < vertex;
+                int neighborRank = artifacts.degreeRank[neighbor];
+                int vertexRank = artifacts.degreeRank[vertex];
 
-                int addToCand = moreEdges || (sameEdges && higherVertex);
-                int addToExcl = lessEdges || (sameEdges && lowerVertex);
+                int addToCand = neighborRank > vertexRank;
+                int addToExcl = neighborRank < vertexRank;
 
                 if (addToCand) {
                     addToList(candidates, neighbor);
@@ -224,21 +197,23 @@ public:
                 neighborIndex = neighborIndex + 1;
             }
 
+            local.build(vertex, candidates, excluded);
+            current = mapToLocal(current);
+            candidates = mapToLocal(candidates);
+            excluded = mapToLocal(excluded);
+
             exploreCliques(current, excluded, candidates);
-            pairIndex = pairIndex + 1;
+            orderIndex = orderIndex + 1;
         }
-
-        return cliques;
     }
 };
 
-std::pair<std::vector<std::vector<int>>, double> startChiba(const Graph& input) {
-    ChibaSimple solver(input);
+double startChiba(const Graph& input, const GraphArtifacts& artifacts, CliqueStats& sink) {
+    ChibaSimple solver(input, artifacts, sink);
     std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
-    std::vector<std::vector<int>> cliqueList = solver.findAllCliques();
+    solver.findAllCliques();
     std::chrono::high_resolution_clock::time_point finish = std::chrono::high_resolution_clock::now();
     int duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - begin).count();
     double timeTaken = duration / 1000.0;
-    std::pair<std::vector<std::vector<int>>, double> resultPair = std::make_pair(cliqueList, timeTaken);
-    return resultPair;
+    return timeTaken;
 }
@@ -0,0 +1,401 @@
+#include "external.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <queue>
+
+typedef std::pair<int, int> Edge;
+
+static std::string runPath(const std::string& tempPrefix, int run) {
+    return tempPrefix + ".run" + std::to_string(run);
+}
+
+// Reports an I/O failure and removes every temporary file before exiting.
+static void failExternal(const std::string& message, const std::string& path,
+                         const std::string& tempPrefix, int runs) {
+    std::cerr << message << path << std::endl;
+    for (int run = 0; run < runs; ++run) {
+        std::remove(runPath(tempPrefix, run).c_str());
+    }
+    std::remove((tempPrefix + ".raw").c_str());
+    std::remove((tempPrefix + ".adj").c_str());
+    exit(1);
+}
+
+static void writeRun(std::vector<Edge>& buffer, const std::string& tempPrefix, ExternalReport& report) {
+    std::sort(buffer.begin(), buffer.end());
+    buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+
+    std::string path = runPath(tempPrefix, report.runs);
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        failExternal("Could not create file: ", path, tempPrefix, report.runs);
+    }
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Edge));
+    out.close();
+    if (!out) {
+        failExternal("Could not write file: ", path, tempPrefix, report.runs + 1);
+    }
+    report.bytesWritten += buffer.size() * sizeof(Edge);
+    ++report.runs;
+    buffer.clear();
+}
+
+// Buffered reader over one sorted run file.
+class RunReader {
+private:
+    std::ifstream file;
+    std::vector<Edge> buffer;
+    size_t position;
+    ExternalReport& report;
+
+    void refill() {
+        buffer.resize(buffer.capacity());
+        file.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(Edge));
+        buffer.resize(file.bad() ? 0 : file.gcount() / sizeof(Edge));
+        report.bytesRead += buffer.size() * sizeof(Edge);
+        position = 0;
+    }
+
+public:
+    RunReader(const std::string& path, size_t capacity, ExternalReport& r)
+        : file(path, std::ios::binary), position(0), report(r) {
+        buffer.reserve(std::max<size_t>(capacity, 1));
+        refill();
+    }
+
+    bool empty() const {
+        return position >= buffer.size();
+    }
+
+    bool failed() const {
+        return !file.is_open() || file.bad();
+    }
+
+    Edge front() const {
+        return buffer[position];
+    }
+
+    void pop() {
+        if (++position >= buffer.size()) {
+            refill();
+        }
+    }
+};
+
+ExternalGraph buildExternalGraph(const std::string& filename, const std::string& tempPrefix,
+                                 long long ramBytes, ExternalReport& report) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file: " << filename << std::endl;
+        exit(1);
+    }
+
+    ExternalGraph graph;
+    graph.adjacencyFile = tempPrefix + ".adj";
+    graph.inputEdges = 0;
+
+    // Pass 1: both directions of every edge, sorted in runs that fit the cap.
+    size_t runCapacity = std::max<long long>(ramBytes / sizeof(Edge), 1024);
+    std::vector<Edge> buffer;
+    buffer.reserve(runCapacity);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        int src, dst;
+        iss >> src >> dst;
+        ++graph.inputEdges;
+        if (src == dst) continue;
+
+        buffer.push_back(std::make_pair(src, dst));
+        buffer.push_back(std::make_pair(dst, src));
+        if (buffer.size() + 2 > runCapacity) {
+            writeRun(buffer, tempPrefix, report);
+        }
+    }
+    if (!buffer.empty()) {
+        writeRun(buffer, tempPrefix, report);
+    }
+    std::vector<Edge>().swap(buffer);
+
+    // Pass 2: k-way merge into a deduplicated adjacency stream of original ids.
+    std::string rawPath = tempPrefix + ".raw";
+    {
+        size_t readerCapacity = runCapacity / std::max(report.runs, 1);
+        std::vector<std::unique_ptr<RunReader>> readers;
+        for (int run = 0; run < report.runs; ++run) {
+            readers.push_back(std::unique_ptr<RunReader>(
+                new RunReader(runPath(tempPrefix, run), readerCapacity, report)));
+            if (readers[run]->failed()) {
+                failExternal("Could not read file: ", runPath(tempPrefix, run), tempPrefix, report.runs);
+            }
+        }
+
+        typedef std::pair<Edge, int> HeapEntry;
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+        for (int run = 0; run < report.runs; ++run) {
+            if (!readers[run]->empty()) {
+                heap.push(std::make_pair(readers[run]->front(), run));
+            }
+        }
+
+        std::ofstream raw(rawPath, std::ios::binary);
+        if (!raw.is_open()) {
+            failExternal("Could not create file: ", rawPath, tempPrefix, report.runs);
+        }
+        Edge last(0, 0);
+        bool first = true;
+        long long written = 0;
+        while (!heap.empty()) {
+            HeapEntry top = heap.top();
+            heap.pop();
+            RunReader* reader = readers[top.second].get();
+            reader->pop();
+            if (reader->failed()) {
+                failExternal("Could not read file: ", runPath(tempPrefix, top.second), tempPrefix, report.runs);
+            }
+            if (!reader->empty()) {
+                heap.push(std::make_pair(reader->front(), top.second));
+            }
+
+            Edge edge = top.first;
+            if (!first && edge == last) continue;
+            if (first || edge.first != last.first) {
+                graph.originalIds.push_back(edge.first);
+                graph.offsets.push_back(written);
+            }
+            raw.write(reinterpret_cast<const char*>(&edge.second), sizeof(int));
+            ++written;
+            last = edge;
+            first = false;
+        }
+        graph.offsets.push_back(written);
+        report.bytesWritten += written * sizeof(int);
+        raw.close();
+        if (!raw) {
+            failExternal("Could not write file: ", rawPath, tempPrefix, report.runs);
+        }
+
+        for (int run = 0; run < report.runs; ++run) {
+            readers[run].reset(); // close the run before removing it
+            std::remove(runPath(tempPrefix, run).c_str());
+        }
+    }
+
+    // Pass 3: rewrite neighbor ids as 0-based vertex indices.
+    {
+        std::ifstream raw(rawPath, std::ios::binary);
+        if (!raw.is_open()) {
+            failExternal("Could not open file: ", rawPath, tempPrefix, 0);
+        }
+        std::ofstream adjacency(graph.adjacencyFile, std::ios::binary);
+        if (!adjacency.is_open()) {
+            failExternal("Could not create file: ", graph.adjacencyFile, tempPrefix, 0);
+        }
+        std::vector<int> chunk(1 << 16);
+        while (raw.read(reinterpret_cast<char*>(chunk.data()), chunk.size() * sizeof(int)) || raw.gcount() > 0) {
+            size_t count = raw.gcount() / sizeof(int);
+            for (size_t i = 0; i < count; ++i) {
+                chunk[i] = std::lower_bound(graph.originalIds.begin(), graph.originalIds.end(), chunk[i])
+                           - graph.originalIds.begin();
+            }
+            adjacency.write(reinterpret_cast<const char*>(chunk.data()), count * sizeof(int));
+            report.bytesRead += count * sizeof(int);
+            report.bytesWritten += count * sizeof(int);
+        }
+        if (raw.bad()) {
+            failExternal("Could not read file: ", rawPath, tempPrefix, 0);
+        }
+        adjacency.close();
+        if (!adjacency) {
+            failExternal("Could not write file: ", graph.adjacencyFile, tempPrefix, 0);
+        }
+    }
+    std::remove(rawPath.c_str());
+
+    std::cout << "Converted " << graph.inputEdges << " directed edges to "
+              << graph.offsets.back() / 2 << " undirected edges in " << report.runs << " sorted runs" << std::endl;
+    std::cout << "Mapped " << graph.originalIds.size() << " original vertices to 0-based indices" << std::endl;
+
+    return graph;
+}
+
+// Holds one block of seeds and every vertex in their closed neighborhoods.
+class BlockLoader {
+private:
+    const ExternalGraph& graph;
+    std::ifstream adjacency;
+    ExternalReport& report;
+    int threads;
+
+    long long degree(int v) const {
+        return graph.offsets[v + 1] - graph.offsets[v];
+    }
+
+    // A member costs its adjacency row, its local rank, and one per-vertex
+    // count in blockStats plus a 32-bit one in each worker's partial stats.
+    long long memberBytes(int v) const {
+        return degree(v) * sizeof(int) + sizeof(std::vector<int>) + sizeof(int)
+               + sizeof(long long) + threads * sizeof(uint32_t);
+    }
+
+public:
+    std::vector<int> seeds;
+    std::vector<int> members;  // global indices of every vertex in the block
+    std::vector<int> stamp;    // stamp[v] == block when v is a member
+    int block;
+    long long bytes;
+
+    BlockLoader(const ExternalGraph& g, ExternalReport& r, int workers)
+        : graph(g), adjacency(g.adjacencyFile, std::ios::binary), report(r), threads(workers),
+          stamp(g.originalIds.size(), -1), block(0), bytes(0) {}
+
+    void readList(int v, std::vector<int>& out) {
+        out.resize(degree(v));
+        adjacency.seekg(graph.offsets[v] * sizeof(int));
+        adjacency.read(reinterpret_cast<char*>(out.data()), out.size() * sizeof(int));
+        if (!adjacency) {
+            std::cerr << "Could not read file: " << graph.adjacencyFile << std::endl;
+            std::remove(graph.adjacencyFile.c_str());
+            exit(1);
+        }
+        report.bytesRead += out.size() * sizeof(int);
+    }
+
+    // Bytes the block would grow by if `v` and its neighbors joined it.
+    long long cost(int v, const std::vector<int>& neighbors) const {
+        long long extra = 0;
+        if (stamp[v] != block) extra += memberBytes(v);
+        for (int u : neighbors) {
+            if (stamp[u] != block) extra += memberBytes(u);
+        }
+        return extra;
+    }
+
+    void add(int v, const std::vector<int>& neighbors) {
+        seeds.push_back(v);
+        if (stamp[v] != block) {
+            stamp[v] = block;
+            members.push_back(v);
+        }
+        for (int u : neighbors) {
+            if (stamp[u] != block) {
+                stamp[u] = block;
+                members.push_back(u);
+            }
+        }
+    }
+
+    // Builds the block subgraph with local indices, restricted to the members.
+    Graph load(std::vector<int>& localSeeds) {
+        std::sort(members.begin(), members.end());
+        Graph local(members.size());
+        std::vector<int> neighbors;
+        for (size_t i = 0; i < members.size(); ++i) {
+            readList(members[i], neighbors);
+            for (int u : neighbors) {
+                if (stamp[u] == block) {
+                    local[i].push_back(std::lower_bound(members.begin(), members.end(), u) - members.begin());
+                }
+            }
+        }
+
+        localSeeds.clear();
+        for (int v : seeds) {
+            localSeeds.push_back(std::lower_bound(members.begin(), members.end(), v) - members.begin());
+        }
+        return local;
+    }
+
+    void release() {
+        seeds.clear();
+        members.clear();
+        bytes = 0;
+        ++block;
+    }
+};
+
+CliqueStats collectExternalCliqueStats(const ExternalGraph& graph, long long ramBytes,
+                                       int threads, ExternalReport& report) {
+    int n = graph.originalIds.size();
+
+    // Seeds in (degree, index) order, as in the in-memory engine.
+    std::vector<int> order(n);
+    for (int v = 0; v < n; ++v) {
+        order[v] = v;
+    }
+    std::sort(order.begin(), order.end(), [&graph](int a, int b) {
+        long long da = graph.offsets[a + 1] - graph.offsets[a];
+        long long db = graph.offsets[b + 1] - graph.offsets[b];
+        if (da != db) {
+            return da < db;
+        }
+        return a < b;
+    });
+    std::vector<int> rank(n);
+    for (int i = 0; i < n; ++i) {
+        rank[order[i]] = i;
+    }
+
+    CliqueStats stats(n);
+    BlockLoader loader(graph, report, std::max(threads, 1));
+    std::vector<int> neighbors;
+
+    auto flush = [&]() {
+        if (loader.seeds.empty()) return;
+        std::vector<int> localSeeds;
+        Graph local = loader.load(localSeeds);
+        std::vector<int> localRank(loader.members.size());
+        for (size_t i = 0; i < loader.members.size(); ++i) {
+            localRank[i] = rank[loader.members[i]];
+        }
+
+        CliqueStats blockStats(loader.members.size());
+        collectSeedCliques(local, localRank, localSeeds, blockStats, threads);
+        stats.merge(blockStats, loader.members);
+
+        report.peakBlockBytes = std::max(report.peakBlockBytes, loader.bytes);
+        if (loader.bytes > ramBytes) {
+            ++report.oversizedBlocks;
+        }
+        ++report.blocks;
+        loader.release();
+    };
+
+    for (int seed : order) {
+        long long degree = graph.offsets[seed + 1] - graph.offsets[seed];
+        if (degree == 0) continue;
+        loader.readList(seed, neighbors);
+        // A seed with no later neighbor owns no maximal clique.
+        bool ownsCliques = false;
+        for (int u : neighbors) {
+            if (rank[u] > rank[seed]) {
+                ownsCliques = true;
+                break;
+            }
+        }
+        if (!ownsCliques) continue;
+
+        long long extra = loader.cost(seed, neighbors);
+        if (!loader.seeds.empty() && loader.bytes + extra > ramBytes) {
+            flush();
+            extra = loader.cost(seed, neighbors);
+        }
+        loader.add(seed, neighbors);
+        loader.bytes += extra;
+    }
+    flush();
+
+    return stats;
+}
+
+void removeExternalGraph(const ExternalGraph& graph) {
+    std::remove(graph.adjacencyFile.c_str());
+}
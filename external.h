@@ -0,0 +1,39 @@
+#ifndef EXTERNAL_H
+#define EXTERNAL_H
+
+#include "stats.h"
+#include <string>
+#include <vector>
+
+// Adjacency stored on disk in CSR form; only per-vertex arrays stay in memory.
+struct ExternalGraph {
+    std::string adjacencyFile;
+    std::vector<int> originalIds;       // sorted, position is the vertex index
+    std::vector<long long> offsets;     // size n + 1, in neighbors
+    long long inputEdges;
+};
+
+struct ExternalReport {
+    long long bytesRead;
+    long long bytesWritten;
+    long long peakBlockBytes;
+    int runs;
+    int blocks;
+    int oversizedBlocks; // single seeds whose neighborhood alone exceeded the cap
+
+    ExternalReport()
+        : bytesRead(0), bytesWritten(0), peakBlockBytes(0), runs(0), blocks(0), oversizedBlocks(0) {}
+};
+
+// Sorts the edge list into CSR blocks under `tempPrefix` using at most
+// `ramBytes` for the in-memory runs.
+ExternalGraph buildExternalGraph(const std::string& filename, const std::string& tempPrefix,
+                                 long long ramBytes, ExternalReport& report);
+
+// Pages in the 2-hop neighborhoods of consecutive seed blocks, enumerates and releases them.
+CliqueStats collectExternalCliqueStats(const ExternalGraph& graph, long long ramBytes,
+                                       int threads, ExternalReport& report);
+
+void removeExternalGraph(const ExternalGraph& graph);
+
+#endif // EXTERNAL_H
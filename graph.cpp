@@ -6,6 +6,11 @@
 #include <unordered_map>
 
 Graph readGraph(const std::string& filename) {
+    std::vector<int> originalIds;
+    return readGraph(filename, originalIds);
+}
+
+Graph readGraph(const std::string& filename, std::vector<int>& originalIds) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Could not open file: " << filename << std::endl;
@@ -36,6 +41,10 @@ Graph readGraph(const std::string& filename) {
 
     int n = vertexMap.size();
     Graph graph(n);
+    originalIds.assign(n, 0);
+    for (const auto& entry : vertexMap) {
+        originalIds[entry.second] = entry.first;
+    }
     
     for (const auto& edge : edges) {
         int src = vertexMap[edge.first];
@@ -66,3 +75,67 @@ int countEdges(const Graph& graph) {
     }
     return count / 2;
 }
+
+GraphArtifacts buildArtifacts(const Graph& graph) {
+    int n = graph.size();
+    GraphArtifacts artifacts;
+
+    // Degree order: counting sort by degree keeps ties in id order.
+    int maxDegree = 0;
+    for (const auto& neighbors : graph) {
+        maxDegree = std::max(maxDegree, static_cast<int>(neighbors.size()));
+    }
+    std::vector<int> bucketStart(maxDegree + 2, 0);
+    for (const auto& neighbors : graph) {
+        bucketStart[neighbors.size() + 1]++;
+    }
+    for (int d = 1; d <= maxDegree + 1; ++d) {
+        bucketStart[d] += bucketStart[d - 1];
+    }
+    std::vector<int> byDegree(n);
+    std::vector<int> position(n);
+    std::vector<int> next = bucketStart;
+    for (int v = 0; v < n; ++v) {
+        position[v] = next[graph[v].size()]++;
+        byDegree[position[v]] = v;
+    }
+
+    artifacts.degreeRank.assign(n, -1);
+    for (int v : byDegree) {
+        if (!graph[v].empty()) {
+            artifacts.degreeRank[v] = artifacts.degreeOrder.size();
+            artifacts.degreeOrder.push_back(v);
+        }
+    }
+
+    // Degeneracy order (Batagelj-Zaversnik): repeatedly remove a vertex of
+    // minimum remaining degree, moving its neighbors down one bucket.
+    std::vector<int> degree(n);
+    for (int v = 0; v < n; ++v) {
+        degree[v] = graph[v].size();
+    }
+    for (int i = 0; i < n; ++i) {
+        int v = byDegree[i];
+        for (int u : graph[v]) {
+            if (degree[u] > degree[v]) {
+                int first = byDegree[bucketStart[degree[u]]];
+                if (first != u) {
+                    std::swap(byDegree[position[u]], byDegree[position[first]]);
+                    std::swap(position[u], position[first]);
+                }
+                bucketStart[degree[u]]++;
+                degree[u]--;
+            }
+        }
+    }
+
+    artifacts.degeneracyPosition.assign(n, -1);
+    for (int v : byDegree) {
+        if (!graph[v].empty()) {
+            artifacts.degeneracyPosition[v] = artifacts.degeneracyOrder.size();
+            artifacts.degeneracyOrder.push_back(v);
+        }
+    }
+
+    return artifacts;
+}
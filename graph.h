@@ -7,6 +7,19 @@
 typedef std::vector<std::vector<int>> Graph;
 
 Graph readGraph(const std::string& filename);
+// Also returns the original id of every 0-based vertex index.
+Graph readGraph(const std::string& filename, std::vector<int>& originalIds);
 int countEdges(const Graph& graph);
 
+// Preprocessing shared by all algorithms, built once per graph.
+// Orders cover non-isolated vertices only; positions are -1 for isolated ones.
+struct GraphArtifacts {
+    std::vector<int> degeneracyOrder;     // smallest-last removal order
+    std::vector<int> degeneracyPosition;
+    std::vector<int> degreeOrder;         // by (degree, id)
+    std::vector<int> degreeRank;
+};
+
+GraphArtifacts buildArtifacts(const Graph& graph);
+
 #endif // GRAPH_H
@@ -1,47 +1,170 @@
 #include "graph.h"
+#include "stats.h"
+#include "external.h"
+#include "profiler.h"
 #include <iostream>
 #include <iomanip>
-#include <unordered_map>
 #include <vector>
 #include <string>
+#include <cstdlib>
 #include <chrono>
+#include <thread>
 
-std::pair<std::vector<std::vector<int>>, double> runTomita(const Graph& graph);
-std::pair<std::vector<std::vector<int>>, double> launchEppstein(const Graph& graph);
-std::pair<std::vector<std::vector<int>>, double> startChiba(const Graph& graph);
+double runTomita(const Graph& graph, const GraphArtifacts& artifacts, CliqueStats& sink);
+double launchEppstein(const Graph& graph, const GraphArtifacts& artifacts, CliqueStats& sink);
+double startChiba(const Graph& graph, const GraphArtifacts& artifacts, CliqueStats& sink);
 
-void analyzeCliques(const std::vector<std::vector<int>>& cliques) {
-    int maxSize = 0;
-    std::unordered_map<int, int> sizeDistribution;
-    
-    for (const auto& clique : cliques) {
-        sizeDistribution[clique.size()]++;
-        if (static_cast<int>(clique.size()) > maxSize) {
-            maxSize = clique.size();
+typedef double (*CliqueAlgorithm)(const Graph&, const GraphArtifacts&, CliqueStats&);
+
+// One selected algorithm and the sink its cliques stream into.
+struct AlgorithmRun {
+    std::string name;
+    CliqueAlgorithm run;
+    CliqueStats sink;
+    double seconds;
+};
+
+bool selectAlgorithms(const std::string& list, std::vector<AlgorithmRun>& runs) {
+    std::string remaining = list + ",";
+    size_t comma;
+    while ((comma = remaining.find(',')) != std::string::npos) {
+        std::string name = remaining.substr(0, comma);
+        remaining = remaining.substr(comma + 1);
+        AlgorithmRun algorithm;
+        algorithm.seconds = 0;
+        if (name == "tomita") {
+            algorithm.name = "Tomita";
+            algorithm.run = runTomita;
+        } else if (name == "eppstein") {
+            algorithm.name = "Eppstein";
+            algorithm.run = launchEppstein;
+        } else if (name == "chiba") {
+            algorithm.name = "Chiba";
+            algorithm.run = startChiba;
+        } else {
+            std::cerr << "Unknown algorithm: " << name << std::endl;
+            return false;
         }
+        runs.push_back(algorithm);
     }
-    
-    std::cout << "Total number of maximal cliques: " << cliques.size() << std::endl;
-    std::cout << "Largest clique size: " << maxSize << std::endl;
+    return true;
+}
+
+void analyzeCliques(const CliqueStats& stats, const std::vector<int>& originalIds) {
+    std::cout << "Total number of maximal cliques: " << stats.total << std::endl;
+    std::cout << "Largest clique size: " << stats.maxSize << std::endl;
     std::cout << "Clique size distribution:" << std::endl;
     
-    for (int i = 2; i <= maxSize; ++i) {
-        if (sizeDistribution[i] > 0) {
-            std::cout << "Size " << i << ": " << sizeDistribution[i] << std::endl;
+    for (int i = 2; i <= std::min(stats.maxSize, MAX_CLIQUE_SIZE); ++i) {
+        if (stats.sizeCounts[i] > 0) {
+            std::cout << "Size " << i << ": " << stats.sizeCounts[i] << std::endl;
+        }
+    }
+    
+    int busiest = -1;
+    for (size_t v = 0; v < stats.vertexCounts.size(); ++v) {
+        // Ties go to the smallest original id so every mode reports the same vertex.
+        if (busiest == -1 || stats.vertexCounts[v] > stats.vertexCounts[busiest] ||
+            (stats.vertexCounts[v] == stats.vertexCounts[busiest] && originalIds[v] < originalIds[busiest])) {
+            busiest = v;
+        }
+    }
+    if (busiest != -1) {
+        std::cout << "Most frequent clique member: vertex " << originalIds[busiest]
+                  << " in " << stats.vertexCounts[busiest] << " cliques" << std::endl;
+    }
+}
+
+void reportEstimate(const CliqueEstimate& estimate) {
+    std::cout << "Sampled " << estimate.sampledSeeds << " of " << estimate.totalSeeds
+              << " seed vertices (95% confidence intervals)" << std::endl;
+    std::cout << "Estimated number of maximal cliques: " << std::fixed << std::setprecision(0)
+              << estimate.total << " +/- " << estimate.totalMargin << std::endl;
+    std::cout << "Estimated clique size distribution:" << std::endl;
+    
+    for (int i = 2; i <= MAX_CLIQUE_SIZE; ++i) {
+        if (estimate.sizeCounts[i] > 0) {
+            std::cout << "Size " << i << ": " << estimate.sizeCounts[i]
+                      << " +/- " << estimate.sizeMargins[i] << std::endl;
         }
     }
 }
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <graph_file>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <graph_file> [--stats] [--estimate <samples>] [--external <ram_mb>] [--profile] [--algo tomita,eppstein,chiba] [--parallel]" << std::endl;
         return 1;
     }
     
     std::string filename = argv[1];
+    bool statsOnly = false;
+    int estimateSamples = 0;
+    long long externalRamMb = 0;
+    bool profile = false;
+    std::string algorithms = "tomita,eppstein,chiba";
+    bool parallel = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--stats") {
+            statsOnly = true;
+        } else if (option == "--estimate" && i + 1 < argc) {
+            estimateSamples = std::atoi(argv[++i]);
+        } else if (option == "--external" && i + 1 < argc) {
+            externalRamMb = std::atoll(argv[++i]);
+        } else if (option == "--profile") {
+            profile = true;
+        } else if (option == "--algo" && i + 1 < argc) {
+            algorithms = argv[++i];
+        } else if (option == "--parallel") {
+            parallel = true;
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    std::vector<AlgorithmRun> runs;
+    if (!selectAlgorithms(algorithms, runs)) {
+        return 1;
+    }
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    PhaseProfiler profiler(profile);
+    
     std::cout << "Reading graph from " << filename << "..." << std::endl;
     
-    Graph graph = readGraph(filename);
+    if (externalRamMb > 0) {
+        long long ramBytes = externalRamMb * 1024 * 1024;
+        ExternalReport report;
+        auto start = std::chrono::high_resolution_clock::now();
+        profiler.begin("External sort");
+        ExternalGraph external = buildExternalGraph(filename, filename + ".ext", ramBytes, report);
+        profiler.end();
+        profiler.begin("External enumeration");
+        CliqueStats stats = collectExternalCliqueStats(external, ramBytes, threads, report);
+        profiler.end();
+        removeExternalGraph(external);
+        auto end = std::chrono::high_resolution_clock::now();
+        double time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0;
+        
+        std::cout << "\n=========== External memory ===========" << std::endl;
+        std::cout << "RAM cap: " << externalRamMb << " MB" << std::endl;
+        std::cout << "Sorted runs: " << report.runs << ", seed blocks: " << report.blocks
+                  << " (" << report.oversizedBlocks << " over the cap)" << std::endl;
+        std::cout << "Largest block: " << std::fixed << std::setprecision(2)
+                  << report.peakBlockBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+        std::cout << "Disk read: " << report.bytesRead / (1024.0 * 1024.0) << " MB, written: "
+                  << report.bytesWritten / (1024.0 * 1024.0) << " MB" << std::endl;
+        
+        std::cout << "\n=========== Analysis ===========" << std::endl;
+        analyzeCliques(stats, external.originalIds);
+        std::cout << "Collected in " << std::fixed << std::setprecision(2) << time << " seconds" << std::endl;
+        profiler.report(std::cout);
+        return 0;
+    }
+    
+    profiler.begin("Load graph");
+    std::vector<int> originalIds;
+    Graph graph = readGraph(filename, originalIds);
+    profiler.end();
     
     int nodeCount = 0;
     for (const auto& neighbors : graph) {
@@ -52,30 +175,78 @@ int main(int argc, char* argv[]) {
     
     std::cout << "Graph loaded with " << nodeCount << " non-isolated nodes." << std::endl;
     std::cout << "Graph has " << countEdges(graph) << " edges." << std::endl;
-    std::cout << "\nRunning Tomita algorithm..." << std::endl;
-    std::pair<std::vector<std::vector<int>>, double> t_result = runTomita(graph);
-    std::vector<std::vector<int>> t_cliques = t_result.first;
-    double t_time = t_result.second;
     
-    std::cout << "\nRunning Eppstein algorithm..." << std::endl;
-    std::pair<std::vector<std::vector<int>>, double> e_result = launchEppstein(graph);
-    std::vector<std::vector<int>> e_cliques = e_result.first;
-    double e_time = e_result.second;
+    profiler.begin("Preprocessing");
+    GraphArtifacts artifacts = buildArtifacts(graph);
+    profiler.end();
+    
+    if (estimateSamples > 0) {
+        std::cout << "\nEstimating clique statistics..." << std::endl;
+        auto start = std::chrono::high_resolution_clock::now();
+        profiler.begin("Estimate");
+        CliqueEstimate estimate = estimateCliqueStats(graph, artifacts, estimateSamples, 12345, threads);
+        profiler.end();
+        auto end = std::chrono::high_resolution_clock::now();
+        double time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0;
+        
+        std::cout << "\n=========== Estimate ===========" << std::endl;
+        reportEstimate(estimate);
+        std::cout << "Estimated in " << std::fixed << std::setprecision(2) << time << " seconds" << std::endl;
+        profiler.report(std::cout);
+        return 0;
+    }
+    
+    if (statsOnly) {
+        std::cout << "\nCollecting clique statistics..." << std::endl;
+        auto start = std::chrono::high_resolution_clock::now();
+        profiler.begin("Statistics");
+        CliqueStats stats = collectCliqueStats(graph, artifacts, threads);
+        profiler.end();
+        auto end = std::chrono::high_resolution_clock::now();
+        double time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0;
+        
+        std::cout << "\n=========== Analysis ===========" << std::endl;
+        analyzeCliques(stats, originalIds);
+        std::cout << "Collected in " << std::fixed << std::setprecision(2) << time << " seconds" << std::endl;
+        profiler.report(std::cout);
+        return 0;
+    }
+    
+    // Only the analyzed run keeps per-vertex counts; the others hold fixed-size histograms.
+    runs[0].sink = CliqueStats(graph.size());
     
-    std::cout << "\nRunning Chiba algorithm..." << std::endl;
-    std::pair<std::vector<std::vector<int>>, double> c_result = startChiba(graph);
-    std::vector<std::vector<int>> c_cliques = c_result.first;
-    double c_time = c_result.second;
+    if (parallel) {
+        for (const auto& algorithm : runs) {
+            std::cout << "\nRunning " << algorithm.name << " algorithm..." << std::endl;
+        }
+        profiler.begin("Algorithms (concurrent)");
+        std::vector<std::thread> workers;
+        for (auto& algorithm : runs) {
+            workers.push_back(std::thread([&graph, &artifacts, &algorithm]() {
+                algorithm.seconds = algorithm.run(graph, artifacts, algorithm.sink);
+            }));
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        profiler.end();
+    } else {
+        for (auto& algorithm : runs) {
+            std::cout << "\nRunning " << algorithm.name << " algorithm..." << std::endl;
+            profiler.begin(algorithm.name);
+            algorithm.seconds = algorithm.run(graph, artifacts, algorithm.sink);
+            profiler.end();
+        }
+    }
     
     std::cout << "\n=========== Results ===========" << std::endl;
-    std::cout << "Tomita algorithm: " << t_cliques.size() 
-              << " cliques in " << std::fixed << std::setprecision(2) << t_time << " seconds" << std::endl;
-    std::cout << "Eppstein algorithm: " << e_cliques.size() 
-              << " cliques in " << std::fixed << std::setprecision(2) << e_time << " seconds" << std::endl;
-    std::cout << "Chiba algorithm: " << c_cliques.size() 
-              << " cliques in " << std::fixed << std::setprecision(2) << c_time << " seconds" << std::endl;
+    for (const auto& algorithm : runs) {
+        std::cout << algorithm.name << " algorithm: " << algorithm.sink.total
+                  << " cliques in " << std::fixed << std::setprecision(2) << algorithm.seconds << " seconds" << std::endl;
+    }
     
     std::cout << "\n=========== Analysis ===========" << std::endl;
-    analyzeCliques(t_cliques);
+    analyzeCliques(runs[0].sink, originalIds);
+    profiler.report(std::cout);
     return 0;
 }
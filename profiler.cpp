@@ -0,0 +1,231 @@
+#include "profiler.h"
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Global allocator hook. Counting is off until a profiler is enabled, so the
+// normal run only pays for one relaxed load per allocation.
+static std::atomic<bool> trackAllocations(false);
+static std::atomic<long long> allocationCount(0);
+static std::atomic<long long> freeCount(0);
+static std::atomic<long long> allocatedBytes(0);
+
+void* operator new(std::size_t size) {
+    if (trackAllocations.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    if (memory != nullptr && trackAllocations.load(std::memory_order_relaxed)) {
+        freeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    ::operator delete(memory);
+}
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static long long peakRssKb() {
+#ifdef __linux__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;
+    }
+#endif
+    return -1;
+}
+
+#ifdef __linux__
+static int openCounter(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.inherit = 1; // include worker threads started after the counter is opened
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+static const char* const counterNames[PROFILE_COUNTERS] = {
+    "cycles", "instructions", "LLC read misses", "branch misses"
+};
+
+static CounterSample readCounter(int fd) {
+    CounterSample sample = {0, 0, 0};
+#ifdef __linux__
+    long long values[3];
+    if (fd >= 0 && read(fd, values, sizeof(values)) == sizeof(values)) {
+        sample.value = values[0];
+        sample.enabled = values[1];
+        sample.running = values[2];
+    }
+#endif
+    return sample;
+}
+
+PhaseProfiler::PhaseProfiler(bool enable)
+    : enabled(enable), startAllocations(0), startFrees(0), startBytes(0), startSeconds(0) {
+    for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+        counterFds[i] = -1;
+    }
+    if (!enabled) {
+        return;
+    }
+    trackAllocations.store(true);
+
+#ifdef __linux__
+    const uint32_t types[PROFILE_COUNTERS] = {
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE,
+        PERF_TYPE_HARDWARE
+    };
+    const uint64_t events[PROFILE_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    // Keep every counter that opens; VMs often expose cycles and instructions
+    // but not the cache events.
+    for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+        counterFds[i] = openCounter(types[i], events[i]);
+        if (counterFds[i] < 0) {
+            counterErrors[i] = std::string("perf_event_open: ") + std::strerror(errno);
+        }
+    }
+#else
+    for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+        counterErrors[i] = "perf_event_open is only available on Linux";
+    }
+#endif
+}
+
+PhaseProfiler::~PhaseProfiler() {
+#ifdef __linux__
+    for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+        if (counterFds[i] >= 0) {
+            close(counterFds[i]);
+        }
+    }
+#endif
+    if (enabled) {
+        trackAllocations.store(false);
+    }
+}
+
+void PhaseProfiler::begin(const std::string& phase) {
+    if (!enabled) {
+        return;
+    }
+    current = PhaseReport();
+    current.name = phase;
+    for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+        current.countersAvailable[i] = counterFds[i] >= 0;
+    }
+    current.countersScaled = false;
+    for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+        startCounters[i] = readCounter(counterFds[i]);
+    }
+    startAllocations = allocationCount.load();
+    startFrees = freeCount.load();
+    startBytes = allocatedBytes.load();
+    startSeconds = nowSeconds();
+}
+
+void PhaseProfiler::end() {
+    if (!enabled) {
+        return;
+    }
+    current.seconds = nowSeconds() - startSeconds;
+    for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+        // When the kernel multiplexes counters, scale the phase's count by the
+        // fraction of the phase the counter was actually running.
+        CounterSample sample = readCounter(counterFds[i]);
+        long long value = sample.value - startCounters[i].value;
+        long long timeEnabled = sample.enabled - startCounters[i].enabled;
+        long long timeRunning = sample.running - startCounters[i].running;
+        if (timeRunning > 0 && timeRunning < timeEnabled) {
+            value = static_cast<long long>(static_cast<double>(value) * timeEnabled / timeRunning);
+            current.countersScaled = true;
+        }
+        current.counters[i] = value;
+    }
+    current.allocations = allocationCount.load() - startAllocations;
+    current.frees = freeCount.load() - startFrees;
+    current.allocatedBytes = allocatedBytes.load() - startBytes;
+    current.peakRssKb = peakRssKb();
+    reports.push_back(current);
+}
+
+void PhaseProfiler::report(std::ostream& out) const {
+    if (!enabled) {
+        return;
+    }
+    out << "\n=========== Profile ===========" << std::endl;
+    int available = 0;
+    for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+        if (counterErrors[i].empty()) {
+            ++available;
+        }
+    }
+    if (available == 0) {
+        out << "Hardware counters unavailable (" << counterErrors[0] << ")" << std::endl;
+    } else {
+        for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+            if (!counterErrors[i].empty()) {
+                out << "Counter " << counterNames[i] << " unavailable (" << counterErrors[i] << ")" << std::endl;
+            }
+        }
+    }
+    for (const auto& phase : reports) {
+        out << phase.name << ": " << std::fixed << std::setprecision(2) << phase.seconds << " seconds" << std::endl;
+        if (available > 0) {
+            std::string values[PROFILE_COUNTERS];
+            for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+                values[i] = phase.countersAvailable[i] ? std::to_string(phase.counters[i]) : "n/a";
+            }
+            out << "  cycles: " << values[0] << ", instructions: " << values[1];
+            if (phase.countersAvailable[0] && phase.countersAvailable[1] && phase.counters[0] > 0) {
+                out << " (IPC " << static_cast<double>(phase.counters[1]) / phase.counters[0] << ")";
+            }
+            out << std::endl;
+            out << "  LLC read misses: " << values[2] << ", branch misses: " << values[3] << std::endl;
+            if (phase.countersScaled) {
+                out << "  (counters were multiplexed; values are scaled estimates)" << std::endl;
+            }
+        }
+        out << "  allocations: " << phase.allocations << " (" << phase.allocatedBytes / (1024.0 * 1024.0)
+            << " MB), frees: " << phase.frees << std::endl;
+        if (phase.peakRssKb >= 0) {
+            out << "  peak RSS so far: " << phase.peakRssKb / 1024.0 << " MB" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+const int PROFILE_COUNTERS = 4; // cycles, instructions, LLC read misses, branch misses
+
+// One perf_event read: the raw count and how long the counter was enabled and running.
+struct CounterSample {
+    long long value;
+    long long enabled;
+    long long running;
+};
+
+struct PhaseReport {
+    std::string name;
+    double seconds;
+    bool countersAvailable[PROFILE_COUNTERS];
+    bool countersScaled; // the kernel multiplexed a counter; values are extrapolated
+    long long counters[PROFILE_COUNTERS];
+    long long allocations;
+    long long frees;
+    long long allocatedBytes;
+    long long peakRssKb;
+};
+
+// Per-phase hardware counters (Linux perf_event_open), allocation counts from
+// the global operator new hook, and peak RSS. A disabled profiler does nothing;
+// an enabled one reports whichever counters opened, plus time, allocations and RSS.
+class PhaseProfiler {
+private:
+    bool enabled;
+    int counterFds[PROFILE_COUNTERS];
+    std::string counterErrors[PROFILE_COUNTERS]; // empty when the counter opened
+    std::vector<PhaseReport> reports;
+    PhaseReport current;
+    CounterSample startCounters[PROFILE_COUNTERS];
+    long long startAllocations;
+    long long startFrees;
+    long long startBytes;
+    double startSeconds;
+
+public:
+    explicit PhaseProfiler(bool enable);
+    ~PhaseProfiler();
+
+    void begin(const std::string& phase);
+    void end();
+    void report(std::ostream& out) const;
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,327 @@
+#include "stats.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+
+CliqueStats::CliqueStats(int vertices) : total(0), maxSize(0), vertexCounts(vertices, 0) {
+    std::fill(sizeCounts, sizeCounts + MAX_CLIQUE_SIZE + 1, 0);
+}
+
+void CliqueStats::record(const std::vector<int>& clique) {
+    int size = std::min(static_cast<int>(clique.size()), MAX_CLIQUE_SIZE);
+    ++total;
+    ++sizeCounts[size];
+    if (static_cast<int>(clique.size()) > maxSize) {
+        maxSize = clique.size();
+    }
+    if (!vertexCounts.empty()) {
+        for (int v : clique) {
+            ++vertexCounts[v];
+        }
+    }
+}
+
+void CliqueStats::record(const std::vector<int>& clique, const std::vector<int>& labels) {
+    int size = std::min(static_cast<int>(clique.size()), MAX_CLIQUE_SIZE);
+    ++total;
+    ++sizeCounts[size];
+    if (static_cast<int>(clique.size()) > maxSize) {
+        maxSize = clique.size();
+    }
+    if (!vertexCounts.empty()) {
+        for (int v : clique) {
+            ++vertexCounts[labels[v]];
+        }
+    }
+}
+
+void CliqueStats::merge(const CliqueStats& other) {
+    total += other.total;
+    maxSize = std::max(maxSize, other.maxSize);
+    for (int i = 0; i <= MAX_CLIQUE_SIZE; ++i) {
+        sizeCounts[i] += other.sizeCounts[i];
+    }
+    if (vertexCounts.size() < other.vertexCounts.size()) {
+        vertexCounts.resize(other.vertexCounts.size(), 0);
+    }
+    for (size_t v = 0; v < other.vertexCounts.size(); ++v) {
+        vertexCounts[v] += other.vertexCounts[v];
+    }
+}
+
+void CliqueStats::merge(const CliqueStats& other, const std::vector<int>& labels) {
+    total += other.total;
+    maxSize = std::max(maxSize, other.maxSize);
+    for (int i = 0; i <= MAX_CLIQUE_SIZE; ++i) {
+        sizeCounts[i] += other.sizeCounts[i];
+    }
+    if (!vertexCounts.empty()) {
+        for (size_t v = 0; v < other.vertexCounts.size(); ++v) {
+            vertexCounts[labels[v]] += other.vertexCounts[v];
+        }
+    }
+}
+
+// Pivoted Bron-Kerbosch restricted to the later neighbors of one seed.
+// Every maximal clique is reported by exactly one seed: its lowest-ranked vertex.
+template <typename Sink>
+class SeedEnumerator {
+private:
+    const Graph& graph;
+    const std::vector<int>& rank;
+    Sink& stats;
+    std::vector<int> R;
+
+    static int countCommon(const std::vector<int>& a, const std::vector<int>& b) {
+        int count = 0;
+        size_t i = 0, j = 0;
+        while (i < a.size() && j < b.size()) {
+            if (a[i] < b[j]) {
+                ++i;
+            } else if (b[j] < a[i]) {
+                ++j;
+            } else {
+                ++count;
+                ++i;
+                ++j;
+            }
+        }
+        return count;
+    }
+
+    int choosePivot(const std::vector<int>& P, const std::vector<int>& X) {
+        int pivot = -1;
+        int maxCount = -1;
+        for (int u : P) {
+            int count = countCommon(P, graph[u]);
+            if (count > maxCount) {
+                maxCount = count;
+                pivot = u;
+            }
+        }
+        for (int u : X) {
+            int count = countCommon(P, graph[u]);
+            if (count > maxCount) {
+                maxCount = count;
+                pivot = u;
+            }
+        }
+        return pivot;
+    }
+
+    void expand(std::vector<int>& P, std::vector<int>& X) {
+        if (P.empty()) {
+            if (X.empty()) {
+                stats.record(R);
+            }
+            return;
+        }
+
+        const std::vector<int>& pivotNeighbors = graph[choosePivot(P, X)];
+        std::vector<int> branches;
+        std::set_difference(P.begin(), P.end(), pivotNeighbors.begin(), pivotNeighbors.end(),
+                            std::back_inserter(branches));
+
+        for (int v : branches) {
+            const std::vector<int>& neighbors = graph[v];
+            std::vector<int> newP, newX;
+            std::set_intersection(P.begin(), P.end(), neighbors.begin(), neighbors.end(),
+                                  std::back_inserter(newP));
+            std::set_intersection(X.begin(), X.end(), neighbors.begin(), neighbors.end(),
+                                  std::back_inserter(newX));
+
+            R.push_back(v);
+            expand(newP, newX);
+            R.pop_back();
+
+            P.erase(std::lower_bound(P.begin(), P.end(), v));
+            X.insert(std::lower_bound(X.begin(), X.end(), v), v);
+        }
+    }
+
+public:
+    SeedEnumerator(const Graph& g, const std::vector<int>& r, Sink& s)
+        : graph(g), rank(r), stats(s) {}
+
+    void run(int seed) {
+        std::vector<int> P, X;
+        for (int neighbor : graph[seed]) {
+            if (rank[neighbor] > rank[seed]) {
+                P.push_back(neighbor);
+            } else {
+                X.push_back(neighbor);
+            }
+        }
+        R.assign(1, seed);
+        expand(P, X);
+    }
+};
+
+static int workerCount(int threads, int seeds) {
+    return std::max(1, std::min(threads, seeds));
+}
+
+// One worker's share of collectSeedCliques. Per-vertex counts are kept in 32
+// bits, half the size of the 64-bit totals, and are added into the shared
+// totals before any of them can overflow: no count can exceed the number of
+// cliques recorded since the last flush.
+class WorkerStats {
+private:
+    std::vector<uint32_t> vertexCounts;
+    uint32_t pending;
+    std::vector<long long>& totals;
+    std::mutex& totalsLock;
+
+public:
+    CliqueStats histogram; // sizes only; vertexCounts stays empty
+
+    WorkerStats(std::vector<long long>& t, std::mutex& lock)
+        : vertexCounts(t.size(), 0), pending(0), totals(t), totalsLock(lock) {}
+
+    void record(const std::vector<int>& clique) {
+        histogram.record(clique);
+        if (vertexCounts.empty()) {
+            return;
+        }
+        for (int v : clique) {
+            ++vertexCounts[v];
+        }
+        if (++pending == std::numeric_limits<uint32_t>::max()) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (pending == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(totalsLock);
+        for (size_t v = 0; v < vertexCounts.size(); ++v) {
+            totals[v] += vertexCounts[v];
+            vertexCounts[v] = 0;
+        }
+        pending = 0;
+    }
+};
+
+void collectSeedCliques(const Graph& graph, const std::vector<int>& rank,
+                        const std::vector<int>& seeds, CliqueStats& stats, int threads) {
+    const int chunk = 64;
+    std::atomic<size_t> next(0);
+    int workers = workerCount(threads, seeds.size());
+    std::mutex totalsLock;
+    std::vector<CliqueStats> local(workers);
+    std::vector<std::thread> pool;
+
+    for (int w = 0; w < workers; ++w) {
+        pool.push_back(std::thread([&, w]() {
+            WorkerStats partial(stats.vertexCounts, totalsLock);
+            SeedEnumerator<WorkerStats> enumerator(graph, rank, partial);
+            size_t begin;
+            while ((begin = next.fetch_add(chunk)) < seeds.size()) {
+                size_t end = std::min(begin + chunk, seeds.size());
+                for (size_t i = begin; i < end; ++i) {
+                    enumerator.run(seeds[i]);
+                }
+            }
+            partial.flush();
+            local[w] = partial.histogram;
+        }));
+    }
+    for (auto& worker : pool) {
+        worker.join();
+    }
+
+    for (const auto& partial : local) {
+        stats.merge(partial);
+    }
+}
+
+CliqueStats collectCliqueStats(const Graph& graph, const GraphArtifacts& artifacts, int threads) {
+    CliqueStats stats(graph.size());
+    collectSeedCliques(graph, artifacts.degreeRank, artifacts.degreeOrder, stats, threads);
+    return stats;
+}
+
+CliqueEstimate estimateCliqueStats(const Graph& graph, const GraphArtifacts& artifacts,
+                                   int samples, unsigned seed, int threads) {
+    const std::vector<int>& seeds = artifacts.degreeOrder;
+    const std::vector<int>& rank = artifacts.degreeRank;
+
+    std::vector<int> sampled = seeds;
+    std::mt19937 rng(seed);
+    std::shuffle(sampled.begin(), sampled.end(), rng);
+    sampled.resize(std::min(static_cast<size_t>(std::max(samples, 1)), sampled.size()));
+
+    // Per-seed counts are summed per worker so the variance can be recovered after the merge.
+    // Bucket 0 carries the per-seed total, since no clique has size 0.
+    struct Moments {
+        std::vector<double> sum;
+        std::vector<double> sumSq;
+        Moments() : sum(MAX_CLIQUE_SIZE + 1, 0.0), sumSq(MAX_CLIQUE_SIZE + 1, 0.0) {}
+    };
+
+    std::atomic<size_t> next(0);
+    int workers = workerCount(threads, sampled.size());
+    std::vector<Moments> local(workers);
+    std::vector<std::thread> pool;
+
+    for (int w = 0; w < workers; ++w) {
+        pool.push_back(std::thread([&, w]() {
+            CliqueStats perSeed;
+            SeedEnumerator<CliqueStats> enumerator(graph, rank, perSeed);
+            size_t i;
+            while ((i = next.fetch_add(1)) < sampled.size()) {
+                enumerator.run(sampled[i]);
+                int top = std::min(perSeed.maxSize, MAX_CLIQUE_SIZE);
+                double count = perSeed.total;
+                local[w].sum[0] += count;
+                local[w].sumSq[0] += count * count;
+                for (int size = 1; size <= top; ++size) {
+                    count = perSeed.sizeCounts[size];
+                    local[w].sum[size] += count;
+                    local[w].sumSq[size] += count * count;
+                    perSeed.sizeCounts[size] = 0;
+                }
+                perSeed.total = 0;
+                perSeed.maxSize = 0;
+            }
+        }));
+    }
+    for (auto& worker : pool) {
+        worker.join();
+    }
+
+    Moments moments;
+    for (const auto& partial : local) {
+        for (int i = 0; i <= MAX_CLIQUE_SIZE; ++i) {
+            moments.sum[i] += partial.sum[i];
+            moments.sumSq[i] += partial.sumSq[i];
+        }
+    }
+
+    CliqueEstimate estimate;
+    estimate.sampledSeeds = sampled.size();
+    estimate.totalSeeds = seeds.size();
+    estimate.sizeCounts.assign(MAX_CLIQUE_SIZE + 1, 0.0);
+    estimate.sizeMargins.assign(MAX_CLIQUE_SIZE + 1, 0.0);
+
+    double n = estimate.totalSeeds;
+    double s = estimate.sampledSeeds;
+    double correction = n > 0 ? 1.0 - s / n : 0.0; // finite population correction
+    for (int i = 0; i <= MAX_CLIQUE_SIZE; ++i) {
+        double mean = s > 0 ? moments.sum[i] / s : 0.0;
+        double variance = s > 1 ? std::max(0.0, (moments.sumSq[i] - s * mean * mean) / (s - 1)) : 0.0;
+        double margin = s > 0 ? 1.96 * n * std::sqrt(variance / s * correction) : 0.0;
+        estimate.sizeCounts[i] = n * mean;
+        estimate.sizeMargins[i] = margin;
+    }
+    estimate.total = estimate.sizeCounts[0];
+    estimate.totalMargin = estimate.sizeMargins[0];
+    return estimate;
+}
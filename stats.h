@@ -0,0 +1,47 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "graph.h"
+#include <vector>
+
+// Cliques larger than this are folded into the last histogram bucket.
+const int MAX_CLIQUE_SIZE = 256;
+
+struct CliqueStats {
+    long long total;
+    int maxSize;
+    long long sizeCounts[MAX_CLIQUE_SIZE + 1];
+    std::vector<long long> vertexCounts; // left empty to skip per-vertex counts
+
+    explicit CliqueStats(int vertices = 0);
+    void record(const std::vector<int>& clique);
+    // Records a clique of local ids; labels[i] is the vertex local id i stands for.
+    void record(const std::vector<int>& clique, const std::vector<int>& labels);
+    void merge(const CliqueStats& other);
+    // Merges stats gathered on a relabeled graph whose vertex i is labels[i] here.
+    void merge(const CliqueStats& other, const std::vector<int>& labels);
+};
+
+struct CliqueEstimate {
+    int sampledSeeds;
+    int totalSeeds;
+    double total;
+    double totalMargin; // half-width of the 95% confidence interval
+    std::vector<double> sizeCounts;
+    std::vector<double> sizeMargins;
+};
+
+// Exact statistics, enumerated per seed vertex in degree order on `threads`
+// workers without materializing the cliques.
+CliqueStats collectCliqueStats(const Graph& graph, const GraphArtifacts& artifacts, int threads);
+
+// Enumerates only the cliques owned by `seeds` under the given vertex ranks.
+// Lets callers run the engine on graphs they built themselves.
+void collectSeedCliques(const Graph& graph, const std::vector<int>& rank,
+                        const std::vector<int>& seeds, CliqueStats& stats, int threads);
+
+// Extrapolates the count and size histogram from `samples` random seed vertices.
+CliqueEstimate estimateCliqueStats(const Graph& graph, const GraphArtifacts& artifacts,
+                                   int samples, unsigned seed, int threads);
+
+#endif // STATS_H
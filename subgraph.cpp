@@ -0,0 +1,76 @@
+#include "subgraph.h"
+#include <algorithm>
+
+LocalSubgraph::LocalSubgraph(const Graph& g)
+    : graph(g), dense(false), words(0), candidateCount(0),
+      localIndex(g.size(), -1) {}
+
+void LocalSubgraph::build(int seed, const std::vector<int>& candidates, const std::vector<int>& excluded) {
+    for (int v : labels) {
+        localIndex[v] = -1;
+    }
+    labels.clear();
+    labels.push_back(seed);
+    localIndex[seed] = 0;
+    for (int v : candidates) {
+        localIndex[v] = labels.size();
+        labels.push_back(v);
+    }
+    candidateCount = candidates.size();
+    for (int v : excluded) {
+        localIndex[v] = labels.size();
+        labels.push_back(v);
+    }
+
+    int k = labels.size();
+    dense = k <= DENSE_THRESHOLD;
+    if (dense) {
+        words = (k + 63) / 64;
+        bits.assign(static_cast<size_t>(k) * words, 0);
+    } else if (static_cast<int>(sparse.size()) < k) {
+        sparse.resize(k);
+    }
+
+    for (int a = 0; a < k; ++a) {
+        std::vector<int>* row = dense ? nullptr : &sparse[a];
+        if (row != nullptr) {
+            row->clear();
+        }
+        // The seed is adjacent to everything; other rows only need the local columns.
+        int columns = a > candidateCount ? candidateCount + 1 : k;
+        const std::vector<int>& neighbors = graph[labels[a]];
+
+        if (a == 0 || static_cast<int>(neighbors.size()) > columns) {
+            // Probe the few local columns instead of scanning a long global row.
+            for (int b = 0; b < columns; ++b) {
+                if (b == a) continue;
+                if (a != 0 && !std::binary_search(neighbors.begin(), neighbors.end(), labels[b])) continue;
+                if (row != nullptr) {
+                    row->push_back(b);
+                } else {
+                    bits[static_cast<size_t>(a) * words + b / 64] |= uint64_t(1) << (b % 64);
+                }
+            }
+        } else {
+            for (int neighbor : neighbors) {
+                int b = localIndex[neighbor];
+                if (b == -1 || b >= columns) continue;
+                if (row != nullptr) {
+                    row->push_back(b);
+                } else {
+                    bits[static_cast<size_t>(a) * words + b / 64] |= uint64_t(1) << (b % 64);
+                }
+            }
+            if (row != nullptr) {
+                std::sort(row->begin(), row->end());
+            }
+        }
+    }
+}
+
+bool LocalSubgraph::connected(int a, int b) const {
+    if (dense) {
+        return (bits[static_cast<size_t>(a) * words + b / 64] >> (b % 64)) & 1;
+    }
+    return std::binary_search(sparse[a].begin(), sparse[a].end(), b);
+}
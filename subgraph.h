@@ -0,0 +1,45 @@
+#ifndef SUBGRAPH_H
+#define SUBGRAPH_H
+
+#include "graph.h"
+#include <cstdint>
+#include <vector>
+
+// Neighborhoods up to this many vertices get a bit matrix instead of sorted lists.
+// At the limit the matrix is 1024 x 16 words (128 KB), which still fits in L2.
+const int DENSE_THRESHOLD = 1024;
+
+// The closed neighborhood of one seed, relabeled to 0..k-1 with the seed as 0.
+// Buffers are kept between builds so the outer loop allocates only when a
+// neighborhood is larger than any seen before.
+class LocalSubgraph {
+private:
+    const Graph& graph;
+    bool dense;
+    int words;
+    int candidateCount;
+    std::vector<int> labels;      // local -> global
+    std::vector<int> localIndex;  // global -> local, -1 outside the subgraph
+    Graph sparse;
+    std::vector<uint64_t> bits;
+
+public:
+    explicit LocalSubgraph(const Graph& g);
+
+    // Candidates get local ids 1..|P| and excluded vertices the ids after them,
+    // each in the given order. Rows of excluded vertices only hold the seed and
+    // candidate columns: the searches never test two excluded vertices.
+    void build(int seed, const std::vector<int>& candidates, const std::vector<int>& excluded);
+
+    int toLocal(int global) const {
+        return localIndex[global];
+    }
+
+    const std::vector<int>& globalLabels() const {
+        return labels;
+    }
+
+    bool connected(int a, int b) const;
+};
+
+#endif // SUBGRAPH_H
@@ -1,15 +1,20 @@
 #include "graph.h"
+#include "stats.h"
 #include <algorithm>
 #include <chrono>
 
 class TomitaAlgorithm {
 private:
     const Graph& graph;
-    std::vector<std::vector<int>> maximalCliques;
+    CliqueStats& sink;
+    
+    bool adjacent(int u, int v) const {
+        return std::binary_search(graph[u].begin(), graph[u].end(), v);
+    }
     
     void expand(std::vector<int>& R, std::vector<int>& P, std::vector<int>& X) {
         if (P.empty() && X.empty()) {
-            maximalCliques.push_back(R);
+            sink.record(R);
             return;
         }
         
@@ -19,7 +24,7 @@ private:
         for (int u : P) {
             int count = 0;
             for (int v : P) {
-                if (std::binary_search(graph[u].begin(), graph[u].end(), v)) {
+                if (adjacent(u, v)) {
                     ++count;
                 }
             }
@@ -32,7 +37,7 @@ private:
         std::vector<int> P_copy = P;
         
         for (int v : P_copy) {
-            if (std::binary_search(graph[pivot].begin(), graph[pivot].end(), v)) {
+            if (adjacent(pivot, v)) {
                 continue;
             }
             
@@ -40,12 +45,12 @@ private:
             
             std::vector<int> newP, newX;
             for (int u : P) {
-                if (std::binary_search(graph[v].begin(), graph[v].end(), u)) {
+                if (adjacent(v, u)) {
                     newP.push_back(u);
                 }
             }
             for (int u : X) {
-                if (std::binary_search(graph[v].begin(), graph[v].end(), u)) {
+                if (adjacent(v, u)) {
                     newX.push_back(u);
                 }
             }
@@ -59,10 +64,9 @@ private:
     }
     
 public:
-    TomitaAlgorithm(const Graph& g) : graph(g) {}
+    TomitaAlgorithm(const Graph& g, CliqueStats& s) : graph(g), sink(s) {}
     
-    std::vector<std::vector<int>> enumerateMaximalCliques() {
-        maximalCliques.clear();
+    void enumerateMaximalCliques() {
         std::vector<int> R, P, X;
         
         for (size_t v = 0; v < graph.size(); ++v) {
@@ -72,19 +76,18 @@ public:
         }
         
         expand(R, P, X);
-        
-        return maximalCliques;
     }
 };
 
-std::pair<std::vector<std::vector<int>>, double> runTomita(const Graph& graph) {
-    TomitaAlgorithm tomita(graph);
+// Tomita seeds from the whole vertex set, so it needs none of the shared artifacts.
+double runTomita(const Graph& graph, const GraphArtifacts&, CliqueStats& sink) {
+    TomitaAlgorithm tomita(graph, sink);
     
     auto start = std::chrono::high_resolution_clock::now();
-    std::vector<std::vector<int>> cliques = tomita.enumerateMaximalCliques();
+    tomita.enumerateMaximalCliques();
     auto end = std::chrono::high_resolution_clock::now();
     
     double time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0;
     
-    return std::make_pair(cliques, time);
+    return time;
 }